@@ -0,0 +1,205 @@
+// Medicións sen ventá da grella de esferas instanciadas de scene_opengl, en modo VBO e procedural.
+// Crea un contexto OpenGL 3.3 core con EGL sen superficie (EGL_MESA_platform_surfaceless),
+// debuxa a esfera, o cono e a grella, vistos dende a cámara 3, nun framebuffer de 800x600, e mide
+// o tempo de reloxo por fotograma, ata o glFinish do último, e o tempo de GPU con GL_TIME_ELAPSED.
+// Tamén compara a imaxe final dos dous modos.
+// Uso: bench_opengl [--frames n] [instancias...]; con Mesa, LIBGL_ALWAYS_SOFTWARE=1 forza llvmpipe
+
+#define GL_GLEXT_PROTOTYPES
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GL/glcorearb.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "scene_opengl.hpp"
+
+const int width = 800, height = 600;
+
+// Contexto OpenGL sen ventá, co framebuffer de cor e profundidade enlazado
+bool createContext() {
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (!getPlatformDisplay) return false;
+    EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (!eglInitialize(display, nullptr, nullptr) || !eglBindAPI(EGL_OPENGL_API)) return false;
+    EGLint attributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+    if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) return false;
+
+    GLuint framebuffer, renderbuffers[2];
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glGenRenderbuffers(2, renderbuffers);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+    glViewport(0, 0, width, height);
+    return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+int main(int argc, char* argv[]) {
+    int frames = 20;
+    std::vector<int> instanceCounts;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--frames" && i + 1 < argc) frames = std::max(std::atoi(argv[++i]), 1);
+        else instanceCounts.push_back(std::max(std::atoi(argv[i]), 0));
+    }
+    if (instanceCounts.empty()) instanceCounts = { 0, 1000, 10000, 50000 };
+
+    if (!createContext()) {
+        std::cerr << "Non se puido crear o contexto OpenGL con EGL" << std::endl;
+        return 1;
+    }
+    std::cout << "GL_RENDERER: " << glGetString(GL_RENDERER) << std::endl;
+
+    GLuint shader = createProgram(vertexShaderSource, fragmentShaderSource);
+    GLuint proceduralShader = createProgram(proceduralVertexShaderSource, fragmentShaderSource);
+
+    // Mesmos parámetros de teselado ca scene_opengl
+    const int coneSegments = 32;
+    const float coneHeight = 1.0f, coneRadius = 0.5f;
+    const int sphereSectors = 32, sphereStacks = 16;
+    const float sphereRadius = 0.5f;
+
+    std::vector<float> coneVertices;
+    generateCone(coneVertices, coneSegments, coneHeight, coneRadius);
+    GLuint coneVAO, coneVBO;
+    createObjectVec(coneVAO, coneVBO, coneVertices);
+    std::vector<float> sphereVertices;
+    generateSphere(sphereVertices, sphereSectors, sphereStacks, sphereRadius);
+    GLuint sphereVAO, sphereVBO;
+    createObjectVec(sphereVAO, sphereVBO, sphereVertices);
+    GLuint emptyVAO;
+    glGenVertexArrays(1, &emptyVAO);
+
+    // Cámara 3 da escena
+    glm::vec3 cameraPosition(4.0f, 2.0f, 4.0f);
+    glm::mat4 view = glm::lookAt(cameraPosition, glm::vec3(0.0f, 0.5f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f/600.0f, 0.1f, 100.0f);
+    glEnable(GL_DEPTH_TEST);
+
+    std::vector<GLuint> timerQueries(frames);
+    glGenQueries(frames, timerQueries.data());
+    std::vector<unsigned char> images[2];
+
+    for (int instances : instanceCounts) {
+        StressGrid grid;
+        createStressGrid(grid, instances, sphereSectors, sphereStacks, sphereRadius);
+
+        for (int mode = 0; mode < 2; ++mode) {
+            bool procedural = mode == 1;
+            GLuint program = procedural ? proceduralShader : shader;
+            glUseProgram(program);
+            glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, glm::value_ptr(view));
+            glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+            glUniform3f(glGetUniformLocation(program, "lightPos"), 2.0f, 3.0f, 2.0f);
+            glUniform3f(glGetUniformLocation(program, "viewPos"), cameraPosition.x, cameraPosition.y, cameraPosition.z);
+            glUniform3f(glGetUniformLocation(program, "lightColor"), 1.0f, 1.0f, 1.0f);
+
+            // Un fotograma de quecemento, para non medir a compilación dos shaders
+            std::chrono::steady_clock::time_point start;
+            for (int frame = -1; frame < frames; ++frame) {
+                if (frame == 0) {
+                    glFinish();
+                    start = std::chrono::steady_clock::now();
+                }
+                glClearColor(0.1f,0.1f,0.1f,1.0f);
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                if (frame >= 0) glBeginQuery(GL_TIME_ELAPSED, timerQueries[frame]);
+
+                glm::mat4 coneModel = glm::translate(glm::mat4(1.0f), glm::vec3(1.0f,0.0f,0.0f));
+                glUniformMatrix4fv(glGetUniformLocation(program, "model"), 1, GL_FALSE, glm::value_ptr(coneModel));
+                glUniform3f(glGetUniformLocation(program, "objectColor"), 0.0f, 1.0f, 0.0f);
+                if (procedural) {
+                    glUniform1i(glGetUniformLocation(program, "shape"), 1);
+                    glUniform1i(glGetUniformLocation(program, "segments"), coneSegments);
+                    glUniform1f(glGetUniformLocation(program, "radius"), coneRadius);
+                    glUniform1f(glGetUniformLocation(program, "height"), coneHeight);
+                    glBindVertexArray(emptyVAO);
+                    glDrawArrays(GL_TRIANGLES, 0, coneSegments * 6);
+                } else {
+                    glBindVertexArray(coneVAO);
+                    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(coneVertices.size() / 6));
+                }
+
+                glm::mat4 sphereModel = glm::translate(glm::mat4(1.0f), glm::vec3(-3.0f, 0.5f, 0.0f));
+                glUniformMatrix4fv(glGetUniformLocation(program, "model"), 1, GL_FALSE, glm::value_ptr(sphereModel));
+                glUniform3f(glGetUniformLocation(program, "objectColor"), 1.0f, 0.5f, 0.0f);
+                if (procedural) {
+                    glUniform1i(glGetUniformLocation(program, "shape"), 2);
+                    glUniform1i(glGetUniformLocation(program, "segments"), sphereSectors);
+                    glUniform1i(glGetUniformLocation(program, "stacks"), sphereStacks);
+                    glUniform1f(glGetUniformLocation(program, "radius"), sphereRadius);
+                    glBindVertexArray(emptyVAO);
+                    glDrawArrays(GL_TRIANGLES, 0, sphereSectors * sphereStacks * 6);
+                } else {
+                    glBindVertexArray(sphereVAO);
+                    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(sphereVertices.size() / 6));
+                }
+
+                if (instances > 0) {
+                    glm::mat4 stressModel = glm::translate(glm::mat4(1.0f),
+                        glm::vec3(-grid.columns * grid.spacing / 2, 0.5f, -3.0f));
+                    glUniformMatrix4fv(glGetUniformLocation(program, "model"), 1, GL_FALSE, glm::value_ptr(stressModel));
+                    beginStressGrid(grid, program, procedural, emptyVAO);
+                    drawStressChunk(grid, program, procedural, 0, instances);
+                    endStressGrid(program);
+                }
+                if (frame >= 0) glEndQuery(GL_TIME_ELAPSED);
+            }
+            glFinish();
+            double wall = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            // Tras o glFinish todas as consultas teñen resultado
+            GLuint64 gpuTime = 0;
+            for (GLuint query : timerQueries) {
+                GLuint64 time = 0;
+                glGetQueryObjectui64v(query, GL_QUERY_RESULT, &time);
+                gpuTime += time;
+            }
+            std::cout << instances << " instances " << (procedural ? "[procedural] " : "[VBO] ")
+                      << wall / frames << " ms/frame, GPU " << gpuTime / 1.0e6 / frames << " ms/frame" << std::endl;
+
+            images[mode].resize(width * height * 4);
+            glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, images[mode].data());
+        }
+
+        // Diferenza entre as imaxes dos dous modos
+        int maxDifference = 0;
+        long differentPixels = 0;
+        for (int i = 0; i < width * height; ++i) {
+            int difference = 0;
+            for (int c = 0; c < 4; ++c) difference = std::max(difference, std::abs(images[0][4 * i + c] - images[1][4 * i + c]));
+            if (difference > 0) ++differentPixels;
+            maxDifference = std::max(maxDifference, difference);
+        }
+        std::cout << instances << " instances: " << differentPixels << " pixels differ between modes, by at most "
+                  << maxDifference << std::endl;
+
+        deleteStressGrid(grid);
+    }
+
+    glDeleteQueries(frames, timerQueries.data());
+    glDeleteVertexArrays(1, &coneVAO);
+    glDeleteBuffers(1, &coneVBO);
+    glDeleteVertexArrays(1, &sphereVAO);
+    glDeleteBuffers(1, &sphereVBO);
+    glDeleteVertexArrays(1, &emptyVAO);
+    glDeleteProgram(shader);
+    glDeleteProgram(proceduralShader);
+    return 0;
+}
@@ -5,90 +5,13 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
 #include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdlib>
 #include <cmath>
 #include <numbers>
 
-// const double pi = 3.14159265358979323846;
-const double pi = acos(-1.0);
-
-// Vertex shader source code
-const char* vertexShaderSource = R"(
-#version 330 core
-layout(location = 0) in vec3 position;
-layout(location = 1) in vec3 normal;
-out vec3 fragNormal;
-out vec3 fragPosition;
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-void main() {
-    fragPosition = vec3(model * vec4(position, 1.0));
-    fragNormal = mat3(transpose(inverse(model))) * normal;
-    gl_Position = projection * view * model * vec4(position, 1.0);
-}
-)";
-
-// Fragment shader source code
-const char* fragmentShaderSource = R"(
-#version 330 core
-in vec3 fragNormal;
-in vec3 fragPosition;
-out vec4 color;
-uniform vec3 lightPos;
-uniform vec3 viewPos;
-uniform vec3 lightColor;
-uniform vec3 objectColor;
-void main() {
-    // Ambient lighting
-    float ambientStrength = 0.1;
-    vec3 ambient = ambientStrength * lightColor;
-
-    // Diffuse lighting
-    vec3 norm = normalize(fragNormal);
-    vec3 lightDir = normalize(lightPos - fragPosition);
-    float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = diff * lightColor;
-
-    // Specular lighting
-    float specularStrength = 0.5;
-    vec3 viewDir = normalize(viewPos - fragPosition);
-    vec3 reflectDir = reflect(-lightDir, norm);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
-    vec3 specular = specularStrength * spec * lightColor;
-
-    // Combine results
-    vec3 result = (ambient + diffuse + specular) * objectColor;
-    color = vec4(result, 1.0);
-}
-)";
-
-// Utility functions for shader compilation and linking
-GLuint compileShader(GLenum type, const char* src) {
-    GLuint shader = glCreateShader(type);
-    glShaderSource(shader, 1, &src, nullptr);
-    glCompileShader(shader);
-    // Check for compilation errors
-    GLint success;
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        GLchar infoLog[512];
-        glGetShaderInfoLog(shader, 512, nullptr, infoLog);
-        std::cerr << "ERROR::SHADER::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-    return shader;
-}
-GLuint createProgram(const char* vs, const char* fs) {
-    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vs);
-    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fs);
-    GLuint program = glCreateProgram();
-    glAttachShader(program, vertexShader);
-    glAttachShader(program, fragmentShader);
-    glLinkProgram(program);
-    // Clean up shaders as they're no longer needed
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-    return program;
-}
+#include "scene_opengl.hpp"
 
 // Cube data (positions and normals)
 float cubeVertices[] = {
@@ -137,137 +60,90 @@ float cubeVertices[] = {
 };
 
 
-// Función para generar una malla de cono (posiciones y normales intercaladas)
-void generateCone(std::vector<float>& vertices, int segments = 32, float height = 1.0f, float radius = 0.5f) {
-    glm::vec3 baseCenter(0.0f, 0.0f, 0.0f);
-    glm::vec3 apex(0.0f, height, 0.0f);
-    glm::vec3 baseNormal(0.0f, -1.0f, 0.0f);
-
-    // Base (fan)
-    for (int i = 0; i < segments; ++i) {
-        float theta0 = 2.0f * pi * i / segments;
-        float theta1 = 2.0f * pi * (i + 1) / segments;
-        float x0 = radius * cos(theta0);
-        float z0 = radius * sin(theta0);
-        float x1 = radius * cos(theta1);
-        float z1 = radius * sin(theta1);
-
-        // Base triangle (center, edge0, edge1)
-        vertices.push_back(baseCenter.x); vertices.push_back(baseCenter.y); vertices.push_back(baseCenter.z);
-        vertices.push_back(baseNormal.x); vertices.push_back(baseNormal.y); vertices.push_back(baseNormal.z);
-        vertices.push_back(x1); vertices.push_back(0.0f); vertices.push_back(z1);
-        vertices.push_back(baseNormal.x); vertices.push_back(baseNormal.y); vertices.push_back(baseNormal.z);
-        vertices.push_back(x0); vertices.push_back(0.0f); vertices.push_back(z0);
-        vertices.push_back(baseNormal.x); vertices.push_back(baseNormal.y); vertices.push_back(baseNormal.z);
-    }
-
-    // Sides
-    for (int i = 0; i < segments; ++i) {
-        float theta0 = 2.0f * pi * i / segments;
-        float theta1 = 2.0f * pi * (i + 1) / segments;
-        float x0 = radius * cos(theta0);
-        float z0 = radius * sin(theta0);
-        float x1 = radius * cos(theta1);
-        float z1 = radius * sin(theta1);
-
-        glm::vec3 p0(x0, 0.0f, z0);
-        glm::vec3 p1(x1, 0.0f, z1);
-
-        // Calculate normals for smooth shading
-        glm::vec3 n0 = glm::normalize(glm::vec3(x0, radius / height, z0));
-        glm::vec3 n1 = glm::normalize(glm::vec3(x1, radius / height, z1));
-        glm::vec3 apexNormal = glm::normalize(glm::vec3((x0 + x1) / 2.0f, radius / height, (z0 + z1) / 2.0f));
-
-        // Side triangle (apex, p1, p0)
-        vertices.push_back(apex.x); vertices.push_back(apex.y); vertices.push_back(apex.z);
-        vertices.push_back(apexNormal.x); vertices.push_back(apexNormal.y); vertices.push_back(apexNormal.z);
-        vertices.push_back(p1.x); vertices.push_back(p1.y); vertices.push_back(p1.z);
-        vertices.push_back(n1.x); vertices.push_back(n1.y); vertices.push_back(n1.z);
-        vertices.push_back(p0.x); vertices.push_back(p0.y); vertices.push_back(p0.z);
-        vertices.push_back(n0.x); vertices.push_back(n0.y); vertices.push_back(n0.z);
-    }
+// Lanza unha consulta de oclusión coa caixa envolvente dun obxecto, sen escribir cor nin profundidade.
+// A caixa é o cubo unidade (boxVAO, ou o VAO baleiro co shader procedural) escalado a size e centrado en center.
+void queryBoundingBox(GLuint query, GLuint program, GLuint boxVAO, const glm::mat4& model, glm::vec3 center, glm::vec3 size) {
+    glm::mat4 boxModel = glm::scale(glm::translate(model, center), size);
+    glUniformMatrix4fv(glGetUniformLocation(program, "model"), 1, GL_FALSE, glm::value_ptr(boxModel));
+    // No shader con VBO non existe "shape", a localización é -1 e a chamada ignórase
+    glUniform1i(glGetUniformLocation(program, "shape"), 0);
+    glBindVertexArray(boxVAO);
+
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDepthMask(GL_FALSE);
+    glBeginQuery(GL_ANY_SAMPLES_PASSED, query);
+    glDrawArrays(GL_TRIANGLES, 0, 36);
+    glEndQuery(GL_ANY_SAMPLES_PASSED);
+    glDepthMask(GL_TRUE);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 }
 
-// Generar una malla de esfera
-void generateSphere(std::vector<float>& vertices, int sectorCount = 32, int stackCount = 16, float radius = 0.5f) {
-    for (int i = 0; i < stackCount; ++i) {
-        float stackAngle1 = pi / 2 - i * pi / stackCount;
-        float stackAngle2 = pi / 2 - (i + 1) * pi / stackCount;
-        float xy1 = radius * cosf(stackAngle1);
-        float z1 = radius * sinf(stackAngle1);
-        float xy2 = radius * cosf(stackAngle2);
-        float z2 = radius * sinf(stackAngle2);
-
-        for (int j = 0; j < sectorCount; ++j) {
-            float sectorAngle1 = j * 2 * pi / sectorCount;
-            float sectorAngle2 = (j + 1) * 2 * pi / sectorCount;
-
-            float x1 = xy1 * cosf(sectorAngle1);
-            float y1 = xy1 * sinf(sectorAngle1);
-            float x2 = xy2 * cosf(sectorAngle1);
-            float y2 = xy2 * sinf(sectorAngle1);
-            float x3 = xy2 * cosf(sectorAngle2);
-            float y3 = xy2 * sinf(sectorAngle2);
-            float x4 = xy1 * cosf(sectorAngle2);
-            float y4 = xy1 * sinf(sectorAngle2);
-
-            // Primer triángulo
-            vertices.push_back(x1); vertices.push_back(y1); vertices.push_back(z1);
-            glm::vec3 n1 = glm::normalize(glm::vec3(x1, y1, z1));
-            vertices.push_back(n1.x); vertices.push_back(n1.y); vertices.push_back(n1.z);
-
-            vertices.push_back(x2); vertices.push_back(y2); vertices.push_back(z2);
-            glm::vec3 n2 = glm::normalize(glm::vec3(x2, y2, z2));
-            vertices.push_back(n2.x); vertices.push_back(n2.y); vertices.push_back(n2.z);
-
-            vertices.push_back(x3); vertices.push_back(y3); vertices.push_back(z2);
-            glm::vec3 n3 = glm::normalize(glm::vec3(x3, y3, z2));
-            vertices.push_back(n3.x); vertices.push_back(n3.y); vertices.push_back(n3.z);
-
-            // Segundo triángulo
-            vertices.push_back(x1); vertices.push_back(y1); vertices.push_back(z1);
-            vertices.push_back(n1.x); vertices.push_back(n1.y); vertices.push_back(n1.z);
-
-            vertices.push_back(x3); vertices.push_back(y3); vertices.push_back(z2);
-            vertices.push_back(n3.x); vertices.push_back(n3.y); vertices.push_back(n3.z);
-
-            vertices.push_back(x4); vertices.push_back(y4); vertices.push_back(z1);
-            glm::vec3 n4 = glm::normalize(glm::vec3(x4, y4, z1));
-            vertices.push_back(n4.x); vertices.push_back(n4.y); vertices.push_back(n4.z);
-        }
+// Consulta lanzada que aínda non se leu. Só se le cando GL_QUERY_RESULT_AVAILABLE o permite,
+// así que a CPU nunca espera pola GPU; mentres, queda pendente para os fotogramas seguintes
+struct PendingQuery {
+    GLuint query;
+    int frame;    // fotograma no que se lanzou
+    int objects;  // obxectos que cobre a caixa, nas consultas de oclusión
+};
+
+// Resultados lidos das consultas pendentes
+struct QueryResults {
+    int queries = 0;
+    GLuint64 total = 0;        // suma dos resultados, en ns nas consultas de tempo
+    int objects = 0;           // obxectos cubertos polas consultas de oclusión
+    int occludedObjects = 0;   // dos anteriores, os que non pasaron ningunha mostra
+};
+
+// Colle unha consulta libre, ou crea outra se todas están pendentes
+GLuint acquireQuery(std::vector<GLuint>& freeQueries) {
+    if (freeQueries.empty()) {
+        GLuint query;
+        glGenQueries(1, &query);
+        return query;
     }
+    GLuint query = freeQueries.back();
+    freeQueries.pop_back();
+    return query;
 }
 
-
-void createObject(GLuint& VAO, GLuint& VBO, float* vertices, size_t vertCount) {
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertCount * sizeof(float), vertices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glBindVertexArray(0);
+// Colle unha consulta de oclusión para a caixa de objects obxectos e déixaa pendente de ler
+GLuint issueOcclusionQuery(std::vector<PendingQuery>& pending, std::vector<GLuint>& freeQueries, int frame, int objects) {
+    GLuint query = acquireQuery(freeQueries);
+    pending.push_back({ query, frame, objects });
+    return query;
 }
 
-void createObjectVec(GLuint& VAO, GLuint& VBO, const std::vector<float>& vertices) {
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glBindVertexArray(0);
+// Le as consultas pendentes lanzadas antes de beforeFrame que xa teñen resultado, acumúlaas
+// en results e devolve as consultas ás libres. As que aínda non o teñen seguen pendentes
+void collectQueries(std::vector<PendingQuery>& pending, std::vector<GLuint>& freeQueries, int beforeFrame, QueryResults& results) {
+    for (size_t i = 0; i < pending.size();) {
+        GLuint available = GL_FALSE;
+        if (pending[i].frame < beforeFrame)
+            glGetQueryObjectuiv(pending[i].query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            ++i;
+            continue;
+        }
+        GLuint64 result = 0;
+        glGetQueryObjectui64v(pending[i].query, GL_QUERY_RESULT, &result);
+        ++results.queries;
+        results.total += result;
+        results.objects += pending[i].objects;
+        if (result == 0) results.occludedObjects += pending[i].objects;
+        freeQueries.push_back(pending[i].query);
+        pending.erase(pending.begin() + i);
+    }
 }
 
 // Camera selection state
 int currentCamera = 0;
 
+// Modo de xeometría: false usa os VBO, true xera os vértices no vertex shader
+bool proceduralGeometry = false;
+
+// Oclusión: prepaso de profundidade do cubo e renderizado condicional do cono, da esfera e dos bloques da grella
+bool occlusionCulling = true;
+
 // Camera positions and targets
 struct Camera {
     glm::vec3 position;
@@ -308,6 +184,8 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
         if (key == GLFW_KEY_1) currentCamera = 0;
         if (key == GLFW_KEY_2) currentCamera = 1;
         if (key == GLFW_KEY_3) currentCamera = 2;
+        if (key == GLFW_KEY_P && action == GLFW_PRESS) proceduralGeometry = !proceduralGeometry;
+        if (key == GLFW_KEY_O && action == GLFW_PRESS) occlusionCulling = !occlusionCulling;
         if (key == GLFW_KEY_LEFT)  cameraAngle -= 0.1f;
         if (key == GLFW_KEY_RIGHT) cameraAngle += 0.1f;
     }
@@ -320,7 +198,19 @@ glm::vec3 getOrbitCameraPosition(float angle, float radius, glm::vec3 target, fl
     return glm::vec3(camX, height, camZ);
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // Modo de medición: --bench informa do tempo por fotograma e --instances N engade
+    // unha grella de N esferas instanciadas como carga de traballo
+    int stressInstances = 0;
+    bool benchmark = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--bench") benchmark = true;
+        if (std::string(argv[i]) == "--instances" && i + 1 < argc) {
+            stressInstances = std::max(std::atoi(argv[i + 1]), 0);
+            benchmark = true;
+        }
+    }
+
     // Inicialización de la ventana y OpenGL
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -328,6 +218,8 @@ int main() {
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     GLFWwindow* window = glfwCreateWindow(800, 600, "Cube Scene - Cameras", nullptr, nullptr);
     glfwMakeContextCurrent(window);
+    // Nas medicións, sen sincronización vertical para non quedar limitadas á taxa do monitor
+    glfwSwapInterval(benchmark ? 0 : 1);
     glewExperimental = GL_TRUE;
     glewInit();
 
@@ -336,6 +228,13 @@ int main() {
 
     // Compilación y enlace de los shaders
     GLuint shader = createProgram(vertexShaderSource, fragmentShaderSource);
+    GLuint proceduralShader = createProgram(proceduralVertexShaderSource, fragmentShaderSource);
+
+    // Parámetros de teselado, compartidos polos VBO e polo modo procedural
+    const int coneSegments = 32;
+    const float coneHeight = 1.0f, coneRadius = 0.5f;
+    const int sphereSectors = 32, sphereStacks = 16;
+    const float sphereRadius = 0.5f;
 
     // Creación del cubo y el cono
     GLuint cubeVAO, cubeVBO;
@@ -343,24 +242,72 @@ int main() {
 
     // Generación de los datos del cono
     std::vector<float> coneVertices;
-    generateCone(coneVertices, 32, 1.0f, 0.5f);
+    generateCone(coneVertices, coneSegments, coneHeight, coneRadius);
     GLuint coneVAO, coneVBO;
     createObjectVec(coneVAO, coneVBO, coneVertices);
 
     // Generación de los datos de la esfera
     std::vector<float> sphereVertices;
-    generateSphere(sphereVertices, 32, 16, 0.5f);
+    generateSphere(sphereVertices, sphereSectors, sphereStacks, sphereRadius);
     GLuint sphereVAO, sphereVBO;
     createObjectVec(sphereVAO, sphereVBO, sphereVertices);
 
+    // VAO baleiro para o modo procedural (o perfil core require un VAO enlazado)
+    GLuint emptyVAO;
+    glGenVertexArrays(1, &emptyVAO);
+
+    // Grella de esferas instanciadas
+    StressGrid stressGrid;
+    createStressGrid(stressGrid, stressInstances, sphereSectors, sphereStacks, sphereRadius);
+
     glEnable(GL_DEPTH_TEST);
 
+    // Consultas de oclusión do cono [0], da esfera [1] e dos bloques da grella [2...]. As lanzadas
+    // nun fotograma deciden o debuxo no seguinte, e lense despois, cando estean dispoñibles.
+    // Cada tipo de consulta ten as súas libres, porque unha consulta queda ligada ao seu destino
+    std::vector<GLuint> freeOcclusionQueries;
+    std::vector<PendingQuery> occlusionQueries;
+    std::vector<GLuint> lastQueries(2 + stressBlockCount(stressGrid));
+    int lastQueryFrame = -1;
+
+    // Medición do tempo por fotograma de cada modo. O tempo de GPU mídese cunha consulta
+    // GL_TIME_ELAPSED por fotograma, que se le cando estea dispoñible
+    std::vector<GLuint> freeTimerQueries;
+    std::vector<PendingQuery> timerQueries;
+    int frame = 0;
+    double benchStart = glfwGetTime();
+    int benchFrames = 0;
+    QueryResults benchGpu;
+    QueryResults benchOcclusion;
+    bool benchMode = proceduralGeometry;
+    bool benchCulling = occlusionCulling;
+
     // Bucle de renderizado
     while (!glfwWindowShouldClose(window)) {
         glClearColor(0.1f,0.1f,0.1f,1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        glUseProgram(shader);
+        // Ao cambiar de modo reiníciase a medición
+        if (benchMode != proceduralGeometry || benchCulling != occlusionCulling) {
+            benchMode = proceduralGeometry;
+            benchCulling = occlusionCulling;
+            benchStart = glfwGetTime();
+            benchFrames = 0;
+            benchGpu = QueryResults();
+            benchOcclusion = QueryResults();
+        }
+        if (benchmark) {
+            timerQueries.push_back({ acquireQuery(freeTimerQueries), frame, 0 });
+            glBeginQuery(GL_TIME_ELAPSED, timerQueries.back().query);
+        }
+
+        // O renderizado condicional usa as consultas do fotograma anterior, se se lanzaron.
+        // Se o debuxo se omite ou non decídeo a GPU, sen que a CPU espere polo resultado
+        bool conditional = occlusionCulling && frame > 0 && lastQueryFrame == frame - 1;
+        std::vector<GLuint> previousQueries = lastQueries;
+
+        GLuint program = proceduralGeometry ? proceduralShader : shader;
+        glUseProgram(program);
 
         Camera cam;
         if (currentCamera == 0) {
@@ -376,11 +323,11 @@ int main() {
         glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f/600.0f, 0.1f, 100.0f);
 
         // Matrices y parámetros de iluminación a los shaders
-        glUniformMatrix4fv(glGetUniformLocation(shader, "view"), 1, GL_FALSE, glm::value_ptr(view));
-        glUniformMatrix4fv(glGetUniformLocation(shader, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-        glUniform3f(glGetUniformLocation(shader, "lightPos"), 2.0f, 3.0f, 2.0f);
-        glUniform3f(glGetUniformLocation(shader, "viewPos"), cam.position.x, cam.position.y, cam.position.z);
-        glUniform3f(glGetUniformLocation(shader, "lightColor"), 1.0f, 1.0f, 1.0f);
+        glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, glm::value_ptr(view));
+        glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+        glUniform3f(glGetUniformLocation(program, "lightPos"), 2.0f, 3.0f, 2.0f);
+        glUniform3f(glGetUniformLocation(program, "viewPos"), cam.position.x, cam.position.y, cam.position.z);
+        glUniform3f(glGetUniformLocation(program, "lightColor"), 1.0f, 1.0f, 1.0f);
 
         // Definicion del cubo
         glm::mat4 cubeModel = glm::translate(glm::mat4(1.0f), glm::vec3(-1.0f,0.5f,0.0f));
@@ -388,8 +335,21 @@ int main() {
         // Añadir rotación al cubo
         float angle = glfwGetTime() * 50.0f; // 50 grados por segundo
         cubeModel = glm::rotate(cubeModel, glm::radians(angle), glm::vec3(0.0f, 1.0f, 0.0f));
-        glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, glm::value_ptr(cubeModel));
-        glBindVertexArray(cubeVAO);
+        glUniformMatrix4fv(glGetUniformLocation(program, "model"), 1, GL_FALSE, glm::value_ptr(cubeModel));
+        if (proceduralGeometry) {
+            glUniform1i(glGetUniformLocation(program, "shape"), 0);
+            glBindVertexArray(emptyVAO);
+        } else {
+            glBindVertexArray(cubeVAO);
+        }
+
+        // Prepaso de profundidade do oclusor: o cubo só escribe no búfer de profundidade
+        if (occlusionCulling) {
+            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            glDrawArrays(GL_TRIANGLES, 0, 36);
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+            glDepthFunc(GL_LEQUAL);
+        }
 
         // Añadir colores por cara
         glm::vec3 faceColors[6] = {
@@ -401,33 +361,132 @@ int main() {
             glm::vec3(0.0f, 1.0f, 1.0f)  // Cyan
         };
         for (int i = 0; i < 6; ++i) {
-            glUniform3f(glGetUniformLocation(shader, "objectColor"),
+            glUniform3f(glGetUniformLocation(program, "objectColor"),
                 faceColors[i].r, faceColors[i].g, faceColors[i].b);
             glDrawArrays(GL_TRIANGLES, i * 6, 6);
         }
+        glDepthFunc(GL_LESS);
 
 
         // Dibujar el cono
         glm::mat4 coneModel = glm::translate(glm::mat4(1.0f), glm::vec3(1.0f,0.0f,0.0f));
-        glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, glm::value_ptr(coneModel));
+        if (occlusionCulling) {
+            lastQueries[0] = issueOcclusionQuery(occlusionQueries, freeOcclusionQueries, frame, 1);
+            queryBoundingBox(lastQueries[0], program, proceduralGeometry ? emptyVAO : cubeVAO, coneModel,
+                glm::vec3(0.0f, coneHeight / 2, 0.0f), glm::vec3(2 * coneRadius, coneHeight, 2 * coneRadius));
+        }
+        glUniformMatrix4fv(glGetUniformLocation(program, "model"), 1, GL_FALSE, glm::value_ptr(coneModel));
         
         // Colorear de color verde
-        glUniform3f(glGetUniformLocation(shader, "objectColor"), 0.0f, 1.0f, 0.0f);
-        glBindVertexArray(coneVAO);
-        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(coneVertices.size() / 6));
+        glUniform3f(glGetUniformLocation(program, "objectColor"), 0.0f, 1.0f, 0.0f);
+        if (conditional) glBeginConditionalRender(previousQueries[0], GL_QUERY_NO_WAIT);
+        if (proceduralGeometry) {
+            glUniform1i(glGetUniformLocation(program, "shape"), 1);
+            glUniform1i(glGetUniformLocation(program, "segments"), coneSegments);
+            glUniform1f(glGetUniformLocation(program, "radius"), coneRadius);
+            glUniform1f(glGetUniformLocation(program, "height"), coneHeight);
+            glBindVertexArray(emptyVAO);
+            glDrawArrays(GL_TRIANGLES, 0, coneSegments * 6);
+        } else {
+            glBindVertexArray(coneVAO);
+            glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(coneVertices.size() / 6));
+        }
+        if (conditional) glEndConditionalRender();
 
         // Dibujar la esfera
         glm::mat4 sphereModel = glm::translate(glm::mat4(1.0f), glm::vec3(-3.0f, 0.5f, 0.0f));
-        glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, glm::value_ptr(sphereModel));
+        if (occlusionCulling) {
+            lastQueries[1] = issueOcclusionQuery(occlusionQueries, freeOcclusionQueries, frame, 1);
+            queryBoundingBox(lastQueries[1], program, proceduralGeometry ? emptyVAO : cubeVAO, sphereModel,
+                glm::vec3(0.0f), glm::vec3(2 * sphereRadius));
+        }
+        glUniformMatrix4fv(glGetUniformLocation(program, "model"), 1, GL_FALSE, glm::value_ptr(sphereModel));
 
         // Colorear de color naranja
-        glUniform3f(glGetUniformLocation(shader, "objectColor"), 1.0f, 0.5f, 0.0f); // naranja
-        glBindVertexArray(sphereVAO);
-        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(sphereVertices.size() / 6));
+        glUniform3f(glGetUniformLocation(program, "objectColor"), 1.0f, 0.5f, 0.0f); // naranja
+        if (conditional) glBeginConditionalRender(previousQueries[1], GL_QUERY_NO_WAIT);
+        if (proceduralGeometry) {
+            glUniform1i(glGetUniformLocation(program, "shape"), 2);
+            glUniform1i(glGetUniformLocation(program, "segments"), sphereSectors);
+            glUniform1i(glGetUniformLocation(program, "stacks"), sphereStacks);
+            glUniform1f(glGetUniformLocation(program, "radius"), sphereRadius);
+            glBindVertexArray(emptyVAO);
+            glDrawArrays(GL_TRIANGLES, 0, sphereSectors * sphereStacks * 6);
+        } else {
+            glBindVertexArray(sphereVAO);
+            glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(sphereVertices.size() / 6));
+        }
+        if (conditional) glEndConditionalRender();
+
+        // Grella de esferas instanciadas
+        if (stressInstances > 0) {
+            glm::mat4 stressModel = glm::translate(glm::mat4(1.0f),
+                glm::vec3(-stressGrid.columns * stressGrid.spacing / 2, 0.5f, -3.0f));
+            glUniform3f(glGetUniformLocation(program, "objectColor"), 1.0f, 0.5f, 0.0f);
+            if (occlusionCulling) {
+                // Bloque a bloque, do máis próximo ao máis afastado: a caixa de cada un próbase contra
+                // a profundidade do escrito ata entón, e o seu debuxo depende da consulta anterior
+                int blockInstances = stressGrid.block * stressGrid.block;
+                for (int block = 0; block < stressBlockCount(stressGrid); ++block) {
+                    int first = block * blockInstances;
+                    int count = std::min(blockInstances, stressInstances - first);
+                    glm::vec3 center, size;
+                    stressBlockBounds(stressGrid, block, center, size);
+                    lastQueries[2 + block] = issueOcclusionQuery(occlusionQueries, freeOcclusionQueries, frame, count);
+                    queryBoundingBox(lastQueries[2 + block], program, proceduralGeometry ? emptyVAO : cubeVAO,
+                        stressModel, center, size);
+
+                    glUniformMatrix4fv(glGetUniformLocation(program, "model"), 1, GL_FALSE, glm::value_ptr(stressModel));
+                    beginStressGrid(stressGrid, program, proceduralGeometry, emptyVAO);
+                    if (conditional) glBeginConditionalRender(previousQueries[2 + block], GL_QUERY_NO_WAIT);
+                    drawStressChunk(stressGrid, program, proceduralGeometry, first, count);
+                    if (conditional) glEndConditionalRender();
+                    // A caixa do seguinte bloque debúxase sen grella
+                    endStressGrid(program);
+                }
+            } else {
+                glUniformMatrix4fv(glGetUniformLocation(program, "model"), 1, GL_FALSE, glm::value_ptr(stressModel));
+                beginStressGrid(stressGrid, program, proceduralGeometry, emptyVAO);
+                drawStressChunk(stressGrid, program, proceduralGeometry, 0, stressInstances);
+                // O resto da escena debúxase sen grella
+                endStressGrid(program);
+            }
+        }
+        if (benchmark) glEndQuery(GL_TIME_ELAPSED);
+
+        // As consultas deste fotograma usaranse no seguinte
+        if (occlusionCulling) lastQueryFrame = frame;
 
         // Intercambia los buffers y procesa eventos
         glfwSwapBuffers(window);
         glfwPollEvents();
+
+        // Tempo de GPU dos fotogramas que xa rematou a GPU, e obxectos que se sabe que estaban ocultos.
+        // As consultas de oclusión deste fotograma non se len ata o seguinte, que as usa no debuxo
+        collectQueries(timerQueries, freeTimerQueries, frame + 1, benchGpu);
+        collectQueries(occlusionQueries, freeOcclusionQueries, frame, benchOcclusion);
+        ++frame;
+
+        // Informe do tempo medio por fotograma cada dous segundos
+        ++benchFrames;
+        double elapsed = glfwGetTime() - benchStart;
+        if (benchmark && elapsed >= 2.0) {
+            std::cout << (benchMode ? "[procedural] " : "[VBO] ")
+                      << (benchCulling ? "[occlusion] " : "")
+                      << 1000.0 * elapsed / benchFrames << " ms/frame ("
+                      << benchFrames / elapsed << " FPS), GPU "
+                      << benchGpu.total / 1.0e6 / std::max(benchGpu.queries, 1) << " ms/frame";
+            if (benchCulling) {
+                std::cout << ", " << static_cast<double>(benchOcclusion.occludedObjects) / benchFrames << " of "
+                          << static_cast<double>(benchOcclusion.objects) / benchFrames
+                          << " tested objects known-occluded per frame";
+            }
+            std::cout << std::endl;
+            benchStart = glfwGetTime();
+            benchFrames = 0;
+            benchGpu = QueryResults();
+            benchOcclusion = QueryResults();
+        }
     }
 
     // Limpieza de recursos
@@ -437,7 +496,14 @@ int main() {
     glDeleteBuffers(1, &coneVBO);
     glDeleteVertexArrays(1, &sphereVAO);
     glDeleteBuffers(1, &sphereVBO);
+    glDeleteVertexArrays(1, &emptyVAO);
+    deleteStressGrid(stressGrid);
+    for (const PendingQuery& pending : timerQueries) freeTimerQueries.push_back(pending.query);
+    for (const PendingQuery& pending : occlusionQueries) freeOcclusionQueries.push_back(pending.query);
+    glDeleteQueries(static_cast<GLsizei>(freeTimerQueries.size()), freeTimerQueries.data());
+    glDeleteQueries(static_cast<GLsizei>(freeOcclusionQueries.size()), freeOcclusionQueries.data());
     glDeleteProgram(shader);
+    glDeleteProgram(proceduralShader);
     glfwTerminate();
     return 0;
 }
@@ -0,0 +1,481 @@
+// Código común á escena e ás medicións (bench_opengl.cpp): shaders, xeración das mallas,
+// creación dos VBO e a grella de esferas instanciadas.
+// Inclúese despois das cabeceiras de OpenGL e de glm.
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+// const double pi = 3.14159265358979323846;
+const double pi = acos(-1.0);
+
+// Vertex shader source code
+const char* vertexShaderSource = R"(
+#version 330 core
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+out vec3 fragNormal;
+out vec3 fragPosition;
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+uniform int instanceFirst;      // índice da primeira instancia do debuxo
+uniform int instanceStride;     // paso entre as instancias do debuxo
+uniform int instanceColumns;    // columnas da grella de instancias, 0 sen grella
+uniform int instanceBlock;      // lado dos bloques da grella
+uniform float instanceSpacing;
+
+// Posición dunha instancia na grella. As instancias van por bloques de instanceBlock x instanceBlock,
+// cada un con índices consecutivos, para poder debuxar e consultar a oclusión de cada bloque por separado
+vec3 instanceOffset(int instance) {
+    if (instanceColumns <= 0) return vec3(0.0);
+    int blockInstances = instanceBlock * instanceBlock;
+    int block = instance / blockInstances;
+    int local = instance % blockInstances;
+    int blocksPerRow = instanceColumns / instanceBlock;
+    int column = (block % blocksPerRow) * instanceBlock + local % instanceBlock;
+    int row = (block / blocksPerRow) * instanceBlock + local / instanceBlock;
+    return vec3(column, 0.0, -row) * instanceSpacing;
+}
+
+void main() {
+    int instance = instanceFirst + instanceStride * gl_InstanceID;
+    vec3 offset = instanceOffset(instance);
+    vec4 worldPosition = model * vec4(position + offset, 1.0);
+    fragPosition = vec3(worldPosition);
+    fragNormal = mat3(transpose(inverse(model))) * normal;
+    gl_Position = projection * view * worldPosition;
+}
+)";
+
+// Vertex shader sen búferes: xera posicións e normais a partir de gl_VertexID
+// Segue a mesma orde de vértices que cubeVertices, generateCone e generateSphere.
+// Cada instancia colle da grella o seu desprazamento e, segundo instance % instanceLevels,
+// o seu teselado: segments e stacks divídense entre 2 por cada nivel. Un só debuxo cubre
+// todos os niveis co número de vértices do máis fino; nos máis grosos sobran vértices,
+// que se levan fóra do volume de visión e forman triángulos degenerados que non se rasterizan
+const char* proceduralVertexShaderSource = R"(
+#version 330 core
+out vec3 fragNormal;
+out vec3 fragPosition;
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+uniform int shape;      // 0: cubo, 1: cono, 2: esfera
+uniform int segments;   // sectores da esfera ou segmentos do cono
+uniform int stacks;     // pisos da esfera
+uniform float radius;
+uniform float height;
+uniform int instanceFirst;      // índice da primeira instancia do debuxo
+uniform int instanceStride;     // paso entre as instancias do debuxo
+uniform int instanceColumns;    // columnas da grella de instancias, 0 sen grella
+uniform int instanceBlock;      // lado dos bloques da grella
+uniform float instanceSpacing;
+uniform int instanceLevels;     // niveis de teselado entre as instancias, 0 sen niveis
+
+const float PI = 3.14159265358979323846;
+
+// Teselado da instancia actual
+int tessSegments;
+int tessStacks;
+
+const vec3 cubePositions[36] = vec3[36](
+    vec3(-0.5, -0.5, -0.5), vec3( 0.5, -0.5, -0.5), vec3( 0.5,  0.5, -0.5),
+    vec3( 0.5,  0.5, -0.5), vec3(-0.5,  0.5, -0.5), vec3(-0.5, -0.5, -0.5),
+    vec3(-0.5, -0.5,  0.5), vec3( 0.5, -0.5,  0.5), vec3( 0.5,  0.5,  0.5),
+    vec3( 0.5,  0.5,  0.5), vec3(-0.5,  0.5,  0.5), vec3(-0.5, -0.5,  0.5),
+    vec3(-0.5,  0.5,  0.5), vec3(-0.5,  0.5, -0.5), vec3(-0.5, -0.5, -0.5),
+    vec3(-0.5, -0.5, -0.5), vec3(-0.5, -0.5,  0.5), vec3(-0.5,  0.5,  0.5),
+    vec3( 0.5,  0.5,  0.5), vec3( 0.5,  0.5, -0.5), vec3( 0.5, -0.5, -0.5),
+    vec3( 0.5, -0.5, -0.5), vec3( 0.5, -0.5,  0.5), vec3( 0.5,  0.5,  0.5),
+    vec3(-0.5, -0.5, -0.5), vec3( 0.5, -0.5, -0.5), vec3( 0.5, -0.5,  0.5),
+    vec3( 0.5, -0.5,  0.5), vec3(-0.5, -0.5,  0.5), vec3(-0.5, -0.5, -0.5),
+    vec3(-0.5,  0.5, -0.5), vec3( 0.5,  0.5, -0.5), vec3( 0.5,  0.5,  0.5),
+    vec3( 0.5,  0.5,  0.5), vec3(-0.5,  0.5,  0.5), vec3(-0.5,  0.5, -0.5)
+);
+const vec3 cubeNormals[6] = vec3[6](
+    vec3(0.0, 0.0, -1.0), vec3(0.0, 0.0, 1.0), vec3(-1.0, 0.0, 0.0),
+    vec3(1.0, 0.0, 0.0), vec3(0.0, -1.0, 0.0), vec3(0.0, 1.0, 0.0)
+);
+
+void cube(int id, out vec3 position, out vec3 normal) {
+    position = cubePositions[id];
+    normal = cubeNormals[id / 6];
+}
+
+void cone(int id, out vec3 position, out vec3 normal) {
+    int tri = id / 3;
+    int corner = id % 3;
+    bool base = tri < tessSegments;
+    int i = base ? tri : tri - tessSegments;
+
+    float theta0 = 2.0 * PI * float(i) / float(tessSegments);
+    float theta1 = 2.0 * PI * float(i + 1) / float(tessSegments);
+    vec3 p0 = vec3(radius * cos(theta0), 0.0, radius * sin(theta0));
+    vec3 p1 = vec3(radius * cos(theta1), 0.0, radius * sin(theta1));
+
+    if (base) {
+        // Triángulo da base (centro, p1, p0)
+        position = corner == 0 ? vec3(0.0) : (corner == 1 ? p1 : p0);
+        normal = vec3(0.0, -1.0, 0.0);
+    } else if (corner == 0) {
+        // Vértice superior
+        position = vec3(0.0, height, 0.0);
+        normal = normalize(vec3((p0.x + p1.x) / 2.0, radius / height, (p0.z + p1.z) / 2.0));
+    } else {
+        position = corner == 1 ? p1 : p0;
+        normal = normalize(vec3(position.x, radius / height, position.z));
+    }
+}
+
+void sphere(int id, out vec3 position, out vec3 normal) {
+    // Desprazamento de piso e sector de cada vértice dos dous triángulos do cadrado
+    const int stackOffset[6] = int[6](0, 1, 1, 0, 1, 0);
+    const int sectorOffset[6] = int[6](0, 0, 1, 0, 1, 1);
+
+    int quad = id / 6;
+    int corner = id % 6;
+    int i = quad / tessSegments + stackOffset[corner];
+    int j = quad % tessSegments + sectorOffset[corner];
+
+    float stackAngle = PI / 2.0 - float(i) * PI / float(tessStacks);
+    float sectorAngle = float(j) * 2.0 * PI / float(tessSegments);
+    float xy = radius * cos(stackAngle);
+    position = vec3(xy * cos(sectorAngle), xy * sin(sectorAngle), radius * sin(stackAngle));
+    normal = normalize(position);
+}
+
+// Posición dunha instancia na grella, coma no vertex shader con VBO
+vec3 instanceOffset(int instance) {
+    if (instanceColumns <= 0) return vec3(0.0);
+    int blockInstances = instanceBlock * instanceBlock;
+    int block = instance / blockInstances;
+    int local = instance % blockInstances;
+    int blocksPerRow = instanceColumns / instanceBlock;
+    int column = (block % blocksPerRow) * instanceBlock + local % instanceBlock;
+    int row = (block / blocksPerRow) * instanceBlock + local / instanceBlock;
+    return vec3(column, 0.0, -row) * instanceSpacing;
+}
+
+void main() {
+    int instance = instanceFirst + instanceStride * gl_InstanceID;
+    int level = instanceLevels > 0 ? instance % instanceLevels : 0;
+    tessSegments = max(segments >> level, 3);
+    tessStacks = max(stacks >> level, 2);
+    int vertexCount = shape == 0 ? 36 : (shape == 1 ? tessSegments * 6 : tessSegments * tessStacks * 6);
+    if (gl_VertexID >= vertexCount) {
+        fragPosition = vec3(0.0);
+        fragNormal = vec3(0.0, 1.0, 0.0);
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        return;
+    }
+    vec3 offset = instanceOffset(instance);
+
+    vec3 position;
+    vec3 normal;
+    if (shape == 0) cube(gl_VertexID, position, normal);
+    else if (shape == 1) cone(gl_VertexID, position, normal);
+    else sphere(gl_VertexID, position, normal);
+
+    vec4 worldPosition = model * vec4(position + offset, 1.0);
+    fragPosition = vec3(worldPosition);
+    fragNormal = mat3(transpose(inverse(model))) * normal;
+    gl_Position = projection * view * worldPosition;
+}
+)";
+
+// Fragment shader source code
+const char* fragmentShaderSource = R"(
+#version 330 core
+in vec3 fragNormal;
+in vec3 fragPosition;
+out vec4 color;
+uniform vec3 lightPos;
+uniform vec3 viewPos;
+uniform vec3 lightColor;
+uniform vec3 objectColor;
+void main() {
+    // Ambient lighting
+    float ambientStrength = 0.1;
+    vec3 ambient = ambientStrength * lightColor;
+
+    // Diffuse lighting
+    vec3 norm = normalize(fragNormal);
+    vec3 lightDir = normalize(lightPos - fragPosition);
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = diff * lightColor;
+
+    // Specular lighting
+    float specularStrength = 0.5;
+    vec3 viewDir = normalize(viewPos - fragPosition);
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
+    vec3 specular = specularStrength * spec * lightColor;
+
+    // Combine results
+    vec3 result = (ambient + diffuse + specular) * objectColor;
+    color = vec4(result, 1.0);
+}
+)";
+
+// Utility functions for shader compilation and linking
+GLuint compileShader(GLenum type, const char* src) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &src, nullptr);
+    glCompileShader(shader);
+    // Check for compilation errors
+    GLint success;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        GLchar infoLog[512];
+        glGetShaderInfoLog(shader, 512, nullptr, infoLog);
+        std::cerr << "ERROR::SHADER::COMPILATION_FAILED\n" << infoLog << std::endl;
+    }
+    return shader;
+}
+GLuint createProgram(const char* vs, const char* fs) {
+    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vs);
+    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fs);
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    glLinkProgram(program);
+    // Clean up shaders as they're no longer needed
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+    return program;
+}
+
+
+// Función para generar una malla de cono (posiciones y normales intercaladas)
+void generateCone(std::vector<float>& vertices, int segments = 32, float height = 1.0f, float radius = 0.5f) {
+    glm::vec3 baseCenter(0.0f, 0.0f, 0.0f);
+    glm::vec3 apex(0.0f, height, 0.0f);
+    glm::vec3 baseNormal(0.0f, -1.0f, 0.0f);
+
+    // Base (fan)
+    for (int i = 0; i < segments; ++i) {
+        float theta0 = 2.0f * pi * i / segments;
+        float theta1 = 2.0f * pi * (i + 1) / segments;
+        float x0 = radius * cos(theta0);
+        float z0 = radius * sin(theta0);
+        float x1 = radius * cos(theta1);
+        float z1 = radius * sin(theta1);
+
+        // Base triangle (center, edge0, edge1)
+        vertices.push_back(baseCenter.x); vertices.push_back(baseCenter.y); vertices.push_back(baseCenter.z);
+        vertices.push_back(baseNormal.x); vertices.push_back(baseNormal.y); vertices.push_back(baseNormal.z);
+        vertices.push_back(x1); vertices.push_back(0.0f); vertices.push_back(z1);
+        vertices.push_back(baseNormal.x); vertices.push_back(baseNormal.y); vertices.push_back(baseNormal.z);
+        vertices.push_back(x0); vertices.push_back(0.0f); vertices.push_back(z0);
+        vertices.push_back(baseNormal.x); vertices.push_back(baseNormal.y); vertices.push_back(baseNormal.z);
+    }
+
+    // Sides
+    for (int i = 0; i < segments; ++i) {
+        float theta0 = 2.0f * pi * i / segments;
+        float theta1 = 2.0f * pi * (i + 1) / segments;
+        float x0 = radius * cos(theta0);
+        float z0 = radius * sin(theta0);
+        float x1 = radius * cos(theta1);
+        float z1 = radius * sin(theta1);
+
+        glm::vec3 p0(x0, 0.0f, z0);
+        glm::vec3 p1(x1, 0.0f, z1);
+
+        // Calculate normals for smooth shading
+        glm::vec3 n0 = glm::normalize(glm::vec3(x0, radius / height, z0));
+        glm::vec3 n1 = glm::normalize(glm::vec3(x1, radius / height, z1));
+        glm::vec3 apexNormal = glm::normalize(glm::vec3((x0 + x1) / 2.0f, radius / height, (z0 + z1) / 2.0f));
+
+        // Side triangle (apex, p1, p0)
+        vertices.push_back(apex.x); vertices.push_back(apex.y); vertices.push_back(apex.z);
+        vertices.push_back(apexNormal.x); vertices.push_back(apexNormal.y); vertices.push_back(apexNormal.z);
+        vertices.push_back(p1.x); vertices.push_back(p1.y); vertices.push_back(p1.z);
+        vertices.push_back(n1.x); vertices.push_back(n1.y); vertices.push_back(n1.z);
+        vertices.push_back(p0.x); vertices.push_back(p0.y); vertices.push_back(p0.z);
+        vertices.push_back(n0.x); vertices.push_back(n0.y); vertices.push_back(n0.z);
+    }
+}
+
+// Generar una malla de esfera
+void generateSphere(std::vector<float>& vertices, int sectorCount = 32, int stackCount = 16, float radius = 0.5f) {
+    for (int i = 0; i < stackCount; ++i) {
+        float stackAngle1 = pi / 2 - i * pi / stackCount;
+        float stackAngle2 = pi / 2 - (i + 1) * pi / stackCount;
+        float xy1 = radius * cosf(stackAngle1);
+        float z1 = radius * sinf(stackAngle1);
+        float xy2 = radius * cosf(stackAngle2);
+        float z2 = radius * sinf(stackAngle2);
+
+        for (int j = 0; j < sectorCount; ++j) {
+            float sectorAngle1 = j * 2 * pi / sectorCount;
+            float sectorAngle2 = (j + 1) * 2 * pi / sectorCount;
+
+            float x1 = xy1 * cosf(sectorAngle1);
+            float y1 = xy1 * sinf(sectorAngle1);
+            float x2 = xy2 * cosf(sectorAngle1);
+            float y2 = xy2 * sinf(sectorAngle1);
+            float x3 = xy2 * cosf(sectorAngle2);
+            float y3 = xy2 * sinf(sectorAngle2);
+            float x4 = xy1 * cosf(sectorAngle2);
+            float y4 = xy1 * sinf(sectorAngle2);
+
+            // Primer triángulo
+            vertices.push_back(x1); vertices.push_back(y1); vertices.push_back(z1);
+            glm::vec3 n1 = glm::normalize(glm::vec3(x1, y1, z1));
+            vertices.push_back(n1.x); vertices.push_back(n1.y); vertices.push_back(n1.z);
+
+            vertices.push_back(x2); vertices.push_back(y2); vertices.push_back(z2);
+            glm::vec3 n2 = glm::normalize(glm::vec3(x2, y2, z2));
+            vertices.push_back(n2.x); vertices.push_back(n2.y); vertices.push_back(n2.z);
+
+            vertices.push_back(x3); vertices.push_back(y3); vertices.push_back(z2);
+            glm::vec3 n3 = glm::normalize(glm::vec3(x3, y3, z2));
+            vertices.push_back(n3.x); vertices.push_back(n3.y); vertices.push_back(n3.z);
+
+            // Segundo triángulo
+            vertices.push_back(x1); vertices.push_back(y1); vertices.push_back(z1);
+            vertices.push_back(n1.x); vertices.push_back(n1.y); vertices.push_back(n1.z);
+
+            vertices.push_back(x3); vertices.push_back(y3); vertices.push_back(z2);
+            vertices.push_back(n3.x); vertices.push_back(n3.y); vertices.push_back(n3.z);
+
+            vertices.push_back(x4); vertices.push_back(y4); vertices.push_back(z1);
+            glm::vec3 n4 = glm::normalize(glm::vec3(x4, y4, z1));
+            vertices.push_back(n4.x); vertices.push_back(n4.y); vertices.push_back(n4.z);
+        }
+    }
+}
+
+void createObject(GLuint& VAO, GLuint& VBO, float* vertices, size_t vertCount) {
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertCount * sizeof(float), vertices, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+}
+
+void createObjectVec(GLuint& VAO, GLuint& VBO, const std::vector<float>& vertices) {
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+}
+
+// Grella de esferas instanciadas para as medicións. As instancias van por bloques de block x block,
+// a fila de bloques máis próxima primeiro, e a instancia i usa o nivel de teselado i % stressLevels,
+// co teselado dividido entre 2 por nivel
+const int stressLevels = 3;
+struct StressGrid {
+    int instances = 0;
+    int columns = 1;     // múltiplo de block
+    int block = 8;
+    float spacing = 1.2f;
+    float radius = 0.5f;
+    int sectors[stressLevels];
+    int stacks[stressLevels];
+    // Unha malla por nivel para o modo VBO; o modo procedural non necesita ningunha
+    GLuint VAO[stressLevels] = {};
+    GLuint VBO[stressLevels] = {};
+};
+
+// Prepara a grella; os VBO só se crean se hai instancias
+void createStressGrid(StressGrid& grid, int instances, int sectors, int stacks, float radius) {
+    grid.instances = instances;
+    int columns = std::max(static_cast<int>(std::ceil(std::sqrt(instances))), 1);
+    grid.columns = (columns + grid.block - 1) / grid.block * grid.block;
+    grid.radius = radius;
+    for (int level = 0; level < stressLevels; ++level) {
+        grid.sectors[level] = std::max(sectors >> level, 3);
+        grid.stacks[level] = std::max(stacks >> level, 2);
+        if (instances > 0) {
+            std::vector<float> levelVertices;
+            generateSphere(levelVertices, grid.sectors[level], grid.stacks[level], radius);
+            createObjectVec(grid.VAO[level], grid.VBO[level], levelVertices);
+        }
+    }
+}
+
+void deleteStressGrid(StressGrid& grid) {
+    if (grid.instances > 0) {
+        glDeleteVertexArrays(stressLevels, grid.VAO);
+        glDeleteBuffers(stressLevels, grid.VBO);
+    }
+}
+
+int stressBlockCount(const StressGrid& grid) {
+    int blockInstances = grid.block * grid.block;
+    return (grid.instances + blockInstances - 1) / blockInstances;
+}
+
+// Caixa envolvente dun bloque, no espazo do modelo da grella
+void stressBlockBounds(const StressGrid& grid, int block, glm::vec3& center, glm::vec3& size) {
+    int blocksPerRow = grid.columns / grid.block;
+    float side = (grid.block - 1) * grid.spacing;
+    float column = (block % blocksPerRow) * grid.block * grid.spacing;
+    float row = (block / blocksPerRow) * grid.block * grid.spacing;
+    center = glm::vec3(column + side / 2, 0.0f, -(row + side / 2));
+    size = glm::vec3(side + 2 * grid.radius, 2 * grid.radius, side + 2 * grid.radius);
+}
+
+// Uniforms comúns a todos os debuxos da grella. O modelo, a cor e as matrices pónense fóra
+void beginStressGrid(const StressGrid& grid, GLuint program, bool procedural, GLuint emptyVAO) {
+    glUniform1i(glGetUniformLocation(program, "instanceColumns"), grid.columns);
+    glUniform1i(glGetUniformLocation(program, "instanceBlock"), grid.block);
+    glUniform1f(glGetUniformLocation(program, "instanceSpacing"), grid.spacing);
+    if (procedural) {
+        // O shader deduce o teselado de cada instancia a partir de gl_InstanceID
+        glUniform1i(glGetUniformLocation(program, "shape"), 2);
+        glUniform1i(glGetUniformLocation(program, "segments"), grid.sectors[0]);
+        glUniform1i(glGetUniformLocation(program, "stacks"), grid.stacks[0]);
+        glUniform1f(glGetUniformLocation(program, "radius"), grid.radius);
+        glUniform1i(glGetUniformLocation(program, "instanceLevels"), stressLevels);
+        glUniform1i(glGetUniformLocation(program, "instanceStride"), 1);
+        glBindVertexArray(emptyVAO);
+    } else {
+        glUniform1i(glGetUniformLocation(program, "instanceStride"), stressLevels);
+    }
+}
+
+// Debuxa as instancias [first, first + count) da grella.
+// O modo procedural fai un só debuxo; o modo VBO, un por nivel coa súa malla
+void drawStressChunk(const StressGrid& grid, GLuint program, bool procedural, int first, int count) {
+    if (count <= 0) return;
+    if (procedural) {
+        glUniform1i(glGetUniformLocation(program, "instanceFirst"), first);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, grid.sectors[0] * grid.stacks[0] * 6, count);
+        return;
+    }
+    for (int level = 0; level < stressLevels; ++level) {
+        // Primeira instancia do nivel dentro do anaco
+        int levelFirst = first + ((level - first % stressLevels) + stressLevels) % stressLevels;
+        if (levelFirst >= first + count) continue;
+        glUniform1i(glGetUniformLocation(program, "instanceFirst"), levelFirst);
+        glBindVertexArray(grid.VAO[level]);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, grid.sectors[level] * grid.stacks[level] * 6,
+            (first + count - 1 - levelFirst) / stressLevels + 1);
+    }
+}
+
+// Deixa o programa listo para debuxar sen grella
+void endStressGrid(GLuint program) {
+    glUniform1i(glGetUniformLocation(program, "instanceFirst"), 0);
+    glUniform1i(glGetUniformLocation(program, "instanceStride"), 0);
+    glUniform1i(glGetUniformLocation(program, "instanceColumns"), 0);
+    glUniform1i(glGetUniformLocation(program, "instanceLevels"), 0);
+}
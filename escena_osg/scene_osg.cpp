@@ -9,6 +9,8 @@
 #include <osg/LightSource>
 #include <osg/MatrixTransform>
 #include <osg/Node>
+#include <osg/NodeVisitor>
+#include <osg/PagedLOD>
 #include <osg/Plane>
 #include <osg/PositionAttitudeTransform>
 #include <osg/Shape>
@@ -16,6 +18,13 @@
 #include <osg/Vec3d>
 #include <osg/ref_ptr>
 
+#include <osgDB/DatabasePager>
+#include <osgDB/ReadFile>
+
+#include <osgGA/TrackballManipulator>
+
+#include <osgUtil/IncrementalCompileOperation>
+
 #include <osgViewer/Viewer>
 #include <osgViewer/ViewerEventHandlers>
 
@@ -149,23 +158,24 @@ public:
 
 	virtual bool handle(const osgGA::GUIEventAdapter& ea,osgGA::GUIActionAdapter&) {
 		if(ea.getEventType() == osgGA::GUIEventAdapter::KEYDOWN) {
+			osg::Matrixd view;
 			switch(ea.getKey()) {
 				case osgGA::GUIEventAdapter::KEY_1:
-					camera->setViewMatrixAsLookAt(
+					view.makeLookAt(
 						osg::Vec3d(1.5, -9.0, 0.5),
 						osg::Vec3d(0.0,  0.0, 0.0),
 						osg::Vec3d(0.0,  0.0, 1.0)
 					);
 					break;
 				case osgGA::GUIEventAdapter::KEY_2:
-					camera->setViewMatrixAsLookAt(
+					view.makeLookAt(
 						osg::Vec3d(1.3, -2.0, 4.0),
 						osg::Vec3d(0.0,  0.0, 0.0),
 						osg::Vec3d(0.0,  0.0, 1.0)
 					);
 					break;
 				case osgGA::GUIEventAdapter::KEY_3:
-					camera->setViewMatrixAsLookAt(
+					view.makeLookAt(
 						osg::Vec3d(6.0, -3.0, 1.0),
 						osg::Vec3d(0.0,  0.0, 0.0),
 						osg::Vec3d(0.0,  0.0, 1.0)
@@ -175,13 +185,23 @@ public:
 					return false;
 			}
 
+			// Cun manipulador (escena paxinada) a vista ponse nel, para que non a sobrescriba
+			osgGA::CameraManipulator* manipulator = viewer->getCameraManipulator();
+			if (manipulator) {
+				manipulator->setByInverseMatrix(view);
+			} else {
+				camera->setViewMatrix(view);
+			}
+
 			// Imaxe para sacar fotografías
 			// https://narkive.com/esFiBYhR.1
 			screenCaptureHandler->setFramesToCapture(1);
 			screenCaptureHandler->captureNextFrame(*viewer);
+			return true;
 		}
 
-		return true;
+		// O resto de eventos quedan para o manipulador da cámara
+		return false;
 	}
 private:
 	osg::Camera* camera;
@@ -189,12 +209,42 @@ private:
 	osgViewer::ScreenCaptureHandler* screenCaptureHandler;
 };
 
+// Conta as teselas residentes: os osg::PagedLOD que teñen cargado o seu detalle
+class ResidentTileCounter : public osg::NodeVisitor
+{
+public:
+	ResidentTileCounter() : osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN), residentTiles(0) {}
+
+	virtual void apply(osg::PagedLOD& plod) {
+		// O fillo 0 é a versión simplificada, que sempre está en memoria
+		if (plod.getNumChildren() > 1) {
+			++residentTiles;
+		}
+		traverse(plod);
+	}
+
+	unsigned int residentTiles;
+};
+
 int main (int argc, char* argv[])
 {
 	// Crear a vista inicial
 	osg::ArgumentParser arguments(&argc, argv);
 	osgViewer::Viewer viewer(arguments);
 
+	// Escena paxinada opcional, xerada con tiles_osg
+	std::string tilesFile;
+	unsigned int pagerThreads = 2;
+	unsigned int maxResidentTiles = 300;
+	arguments.read("--tiles", tilesFile);
+	arguments.read("--pager-threads", pagerThreads);
+	arguments.read("--max-tiles", maxResidentTiles);
+	if (pagerThreads == 0) {
+		// Sen fíos de carga nunca se cargaría ningunha tesela
+		std::cerr << "--pager-threads ten que ser polo menos 1" << std::endl;
+		return 1;
+	}
+
 	// https://narkive.com/esFiBYhR.1
 	osg::ref_ptr<osgViewer::ScreenCaptureHandler> screenCaptureHandler (new osgViewer::ScreenCaptureHandler());
 	screenCaptureHandler->setCaptureOperation(new osgViewer::ScreenCaptureHandler::WriteToFile("image", "png"));
@@ -206,6 +256,16 @@ int main (int argc, char* argv[])
 	root->addChild(drawCone());
 	root->addChild(buildLightsource());
 
+	if (!tilesFile.empty()) {
+		// Só se le a raíz; o resto de teselas cárgaas o DatabasePager segundo a distancia á cámara
+		osg::ref_ptr<osg::Node> tiles = osgDB::readRefNodeFile(tilesFile);
+		if (!tiles) {
+			std::cerr << "Non se puido ler " << tilesFile << std::endl;
+			return 1;
+		}
+		root->addChild(tiles);
+	}
+
 	osg::ref_ptr<osg::StateSet> ss = root->getOrCreateStateSet();
 	ss->setMode(GL_LIGHT1, osg::StateAttribute::ON);
 	ss->setMode(GL_LIGHT0, osg::StateAttribute::OFF);
@@ -244,20 +304,50 @@ int main (int argc, char* argv[])
 
 	// Xestionar a cámara, para poder cambiar premendo as teclas 1, 2 e 3.
 	viewer.addEventHandler(new CameraChange(viewer.getCamera(), &viewer, screenCaptureHandler));
-	// https://stackoverflow.com/a/21267807
-	// Importante establecelo a NULL para que non sobrescriba a cámara
-	viewer.setCameraManipulator(NULL);
-	viewer.getCamera()->setViewMatrixAsLookAt(
-		osg::Vec3d(1.5, -9.0, 0.5),
-		osg::Vec3d(0.0,  0.0, 0.0),
-		osg::Vec3d(0.0,  0.0, 1.0)
-	);
+	if (tilesFile.empty()) {
+		// https://stackoverflow.com/a/21267807
+		// Importante establecelo a NULL para que non sobrescriba a cámara
+		viewer.setCameraManipulator(NULL);
+		viewer.getCamera()->setViewMatrixAsLookAt(
+			osg::Vec3d(1.5, -9.0, 0.5),
+			osg::Vec3d(0.0,  0.0, 0.0),
+			osg::Vec3d(0.0,  0.0, 1.0)
+		);
+	} else {
+		// Na escena paxinada hai que moverse libremente para cargar teselas
+		viewer.setCameraManipulator(new osgGA::TrackballManipulator);
+	}
+
+	// Paxinación: fíos de carga, límite de teselas residentes e precompilación dos obxectos de GL.
+	// A IncrementalCompileOperation reparte a compilación entre fotogramas para que non haxa saltos.
+	osgDB::DatabasePager* pager = viewer.getDatabasePager();
+	if (!tilesFile.empty()) {
+		pager->setUpThreads(pagerThreads, 0);
+		pager->setTargetMaximumNumberOfPageLOD(maxResidentTiles);
+		pager->setDoPreCompile(true);
+		osg::ref_ptr<osgUtil::IncrementalCompileOperation> ico (new osgUtil::IncrementalCompileOperation);
+		ico->setTargetFrameRate(60.0);
+		viewer.setIncrementalCompileOperation(ico);
+	}
 
 	// Lanzar a aplicación
 	// Non se pode usar viewer.run() por que sobrescribe o manipulador da cámara.
 	viewer.realize();
+	osg::Timer_t lastReport = osg::Timer::instance()->tick();
 	while(!viewer.done()) {
 		viewer.frame();
+
+		// Informe da paxinación cada dous segundos
+		if (!tilesFile.empty() && osg::Timer::instance()->delta_s(lastReport, osg::Timer::instance()->tick()) >= 2.0) {
+			ResidentTileCounter counter;
+			root->accept(counter);
+			std::cout << counter.residentTiles << " resident tiles, "
+			          << pager->getFileRequestListSize() << " pending requests, page-in latency avg "
+			          << pager->getAverageTimeToMergeTiles() * 1000.0 << " ms, max "
+			          << pager->getMaximumTimeToMergeTile() * 1000.0 << " ms" << std::endl;
+			pager->resetStats();
+			lastReport = osg::Timer::instance()->tick();
+		}
 	}
 
 	return 0;
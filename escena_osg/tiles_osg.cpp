@@ -0,0 +1,195 @@
+// Xera un mundo moi grande en teselas .osgb, organizadas nunha árbore cuaternaria de osg::PagedLOD.
+// Cada tesela garda unha versión simplificada de si mesma e o nome do ficheiro co seu detalle,
+// que cargará o osgDB::DatabasePager só cando a cámara se achegue.
+// Uso: tiles_osg [--output dir] [--levels n] [--cells n] [--cell-size s] [--lod-scale f]
+
+#include <cfloat>
+#include <climits>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <osg/ArgumentParser>
+#include <osg/Geode>
+#include <osg/Group>
+#include <osg/PagedLOD>
+#include <osg/Shape>
+#include <osg/ShapeDrawable>
+#include <osg/Timer>
+#include <osg/ref_ptr>
+
+#include <osgDB/FileNameUtils>
+#include <osgDB/FileUtils>
+#include <osgDB/WriteFile>
+
+// Altura do chan do mundo, por debaixo dos obxectos de scene_osg
+const float groundHeight = -1.0f;
+
+// Parámetros do mundo xerado
+struct World {
+	std::string output;  // Directorio de saída
+	int levels;          // Profundidade da árbore, as follas están no nivel levels
+	int cellsPerLeaf;    // Celas por lado en cada tesela folla, cun obxecto por cela
+	float cellSize;      // Lado de cada cela
+	float lodScale;      // Distancia de cambio de detalle, en radios da tesela
+
+	int cellsPerSide() const { return cellsPerLeaf << levels; }
+	float size() const { return cellsPerSide() * cellSize; }
+};
+
+// Estatísticas da xeración
+unsigned long long numTiles = 0;
+unsigned long long bytesWritten = 0;
+
+// Enteiro pseudoaleatorio para a cela (i, j).
+// Cada tesela xera así os seus obxectos sen ter o mundo enteiro en memoria.
+unsigned int cellHash(int i, int j) {
+	unsigned int h = static_cast<unsigned int>(i) * 73856093u ^ static_cast<unsigned int>(j) * 19349663u;
+	h ^= h >> 13;
+	h *= 0x5bd1e995u;
+	h ^= h >> 15;
+	return h;
+}
+
+// Debuxa o obxecto dunha cela: un cubo, unha esfera ou un cono, coma na escena orixinal
+osg::ref_ptr<osg::ShapeDrawable> drawCell(const World& world, int i, int j, float detail) {
+	unsigned int h = cellHash(i, j);
+	float half = world.size() / 2;
+	osg::Vec3 base((i + 0.5f) * world.cellSize - half, (j + 0.5f) * world.cellSize - half, groundHeight);
+	// Escala entre 0.5 e 1.5
+	float scale = 0.5f + ((h >> 8) & 0xff) / 255.0f;
+
+	osg::ref_ptr<osg::Shape> shape;
+	osg::Vec4 color;
+	switch (h % 3) {
+		case 0:
+			shape = new osg::Box(base + osg::Vec3(0.0f, 0.0f, 0.25f * scale), 0.5f * scale);
+			color = osg::Vec4(1.0f, 0.0f, 0.0f, 1.0f);
+			break;
+		case 1:
+			shape = new osg::Sphere(base + osg::Vec3(0.0f, 0.0f, 0.35f * scale), 0.35f * scale);
+			color = osg::Vec4(1.0f, 0.5f, 0.0f, 1.0f);
+			break;
+		default:
+			// O centro do cono está a un cuarto da altura sobre a base
+			shape = new osg::Cone(base + osg::Vec3(0.0f, 0.0f, 0.125f * scale), 0.35f * scale, 0.5f * scale);
+			color = osg::Vec4(0.0f, 1.0f, 0.0f, 1.0f);
+			break;
+	}
+
+	osg::ref_ptr<osg::TessellationHints> hints (new osg::TessellationHints);
+	hints->setDetailRatio(detail);
+	osg::ref_ptr<osg::ShapeDrawable> drawable = new osg::ShapeDrawable(shape, hints);
+	// A cor da ShapeDrawable gárdase no .osgb; un array de cores sobrescribiríase ao lela
+	drawable->setColor(color);
+
+	return drawable;
+}
+
+// Debuxa os obxectos dunha tesela, collendo unha de cada stride celas en cada eixo
+osg::ref_ptr<osg::Geode> drawTile(const World& world, int level, int x, int y, int stride, float detail) {
+	int cellsPerTile = world.cellsPerSide() >> level;
+	osg::ref_ptr<osg::Geode> geode = new osg::Geode;
+	for (int i = x * cellsPerTile; i < (x + 1) * cellsPerTile; i += stride) {
+		for (int j = y * cellsPerTile; j < (y + 1) * cellsPerTile; j += stride) {
+			geode->addDrawable(drawCell(world, i, j, detail));
+		}
+	}
+	return geode;
+}
+
+// Escribe un nodo no directorio de saída
+bool writeTile(const World& world, osg::Node& node, const std::string& fileName) {
+	std::string path = osgDB::concatPaths(world.output, fileName);
+	if (!osgDB::writeNodeFile(node, path)) {
+		std::cerr << "Non se puido escribir " << path << std::endl;
+		return false;
+	}
+
+	std::ifstream written(path.c_str(), std::ios::binary | std::ios::ate);
+	bytesWritten += static_cast<unsigned long long>(written.tellg());
+	++numTiles;
+	return true;
+}
+
+// Crea o nodo paxinado dunha tesela e escribe en disco o seu detalle.
+// Nas follas o detalle son todos os obxectos; no resto, os nodos paxinados das catro subteselas.
+// Percórrese en profundidade, polo que en memoria só hai unha rama da árbore.
+osg::ref_ptr<osg::PagedLOD> buildTile(const World& world, int level, int x, int y) {
+	osg::ref_ptr<osg::Node> detail;
+	if (level == world.levels) {
+		detail = drawTile(world, level, x, y, 1, 1.0f);
+	} else {
+		osg::ref_ptr<osg::Group> children (new osg::Group);
+		for (int dx = 0; dx < 2; ++dx) {
+			for (int dy = 0; dy < 2; ++dy) {
+				osg::ref_ptr<osg::PagedLOD> child = buildTile(world, level + 1, 2 * x + dx, 2 * y + dy);
+				if (!child) return NULL;
+				children->addChild(child);
+			}
+		}
+		detail = children;
+	}
+
+	std::ostringstream fileName;
+	fileName << "tile_" << level << "_" << x << "_" << y << ".osgb";
+	if (!writeTile(world, *detail, fileName.str())) return NULL;
+
+	float tileSize = world.size() / (1 << level);
+	float half = world.size() / 2;
+	// Semidiagonal da tesela máis a altura máxima dos obxectos
+	float radius = tileSize * 0.7072f + 1.5f;
+	float cutoff = radius * world.lodScale;
+
+	osg::ref_ptr<osg::PagedLOD> plod (new osg::PagedLOD);
+	plod->setCenterMode(osg::LOD::USER_DEFINED_CENTER);
+	plod->setCenter(osg::Vec3((x + 0.5f) * tileSize - half, (y + 0.5f) * tileSize - half, groundHeight));
+	plod->setRadius(radius);
+	// De lonxe, unha mostra dos obxectos con pouca teselación; tantos coma nunha folla
+	plod->addChild(drawTile(world, level, x, y, 1 << (world.levels - level), 0.2f), cutoff, FLT_MAX);
+	// De preto, o detalle, que se carga baixo demanda
+	plod->setFileName(1, fileName.str());
+	plod->setRange(1, 0.0f, cutoff);
+
+	return plod;
+}
+
+int main (int argc, char* argv[])
+{
+	osg::ArgumentParser arguments(&argc, argv);
+
+	World world = { "tiles", 5, 8, 4.0f, 4.0f };
+	arguments.read("--output", world.output);
+	arguments.read("--levels", world.levels);
+	arguments.read("--cells", world.cellsPerLeaf);
+	arguments.read("--cell-size", world.cellSize);
+	arguments.read("--lod-scale", world.lodScale);
+
+	// As celas por lado, cellsPerLeaf << levels, teñen que caber nun int
+	if (world.levels < 0 || world.levels > 30 || world.cellsPerLeaf < 1 || (world.cellsPerLeaf > (INT_MAX >> world.levels))
+	    || world.cellSize <= 0.0f || world.lodScale <= 0.0f) {
+		std::cerr << "Uso: " << arguments.getApplicationName()
+		          << " [--output dir] [--levels n] [--cells n] [--cell-size s] [--lod-scale f]" << std::endl;
+		return 1;
+	}
+	if (!osgDB::makeDirectory(world.output)) {
+		std::cerr << "Non se puido crear o directorio " << world.output << std::endl;
+		return 1;
+	}
+
+	osg::Timer_t start = osg::Timer::instance()->tick();
+
+	// A raíz é a única tesela que carga scene_osg ao comezar
+	osg::ref_ptr<osg::PagedLOD> root = buildTile(world, 0, 0, 0);
+	if (!root || !writeTile(world, *root, "root.osgb")) return 1;
+
+	double seconds = osg::Timer::instance()->delta_s(start, osg::Timer::instance()->tick());
+	unsigned long long numObjects = static_cast<unsigned long long>(world.cellsPerSide()) * world.cellsPerSide();
+	std::cout << "Wrote " << numTiles << " tiles (" << numObjects << " objects, "
+	          << bytesWritten / (1024.0 * 1024.0) << " MB, "
+	          << bytesWritten / 1024.0 / numTiles << " KB per tile) in " << seconds << " s to "
+	          << osgDB::concatPaths(world.output, "root.osgb") << std::endl;
+
+	return 0;
+}